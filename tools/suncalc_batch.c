@@ -0,0 +1,124 @@
+/*
+ * host-side batch version of src/suncalc.c
+ *
+ * Same algorithm as calcSun(), but the range fixups and the cosH checks are
+ * written without branches so the inner loop can be vectorized by the
+ * compiler. Uses the host libm instead of my_math, so times differ from the
+ * watch by up to about 1.1 minutes; "make check" holds them to 1.5 minutes
+ * and requires the no-event (0) results to match exactly.
+ */
+#include <math.h>
+#include <pthread.h>
+#include "suncalc_batch.h"
+
+#define DEG (3.14159265358979f/180.0f)
+
+/* floorf() only vectorizes with SSE4.1; this one does on any x86_64 */
+static inline float fast_floor(float x)
+{
+  float t = (float)(int)x;
+  return t - (float)(t > x);
+}
+
+void calcSunBatch(const SunBatch *in, size_t first, size_t count, int sunset, float *out)
+{
+  const float hour = sunset ? 18.0f : 6.0f;
+  const float sign = sunset ? 1.0f : -1.0f;
+  const float base = sunset ? 0.0f : 360.0f;
+  const int *restrict years = in->year;
+  const int *restrict months = in->month;
+  const int *restrict days = in->day;
+  const float *restrict latitudes = in->latitude;
+  const float *restrict longitudes = in->longitude;
+  const float *restrict zeniths = in->zenith;
+  float *restrict res = out;
+  size_t i;
+
+  for (i = first; i < first + count; i++)
+  {
+    int year = years[i];
+    int month = months[i];
+    int N1 = 275 * month / 9;
+    int N2 = (month + 9) / 12;
+    int N3 = 1 + (year - 4 * (year / 4) + 2) / 3;
+    int N = N1 - (N2 * N3) + days[i] - 30;
+
+    float lngHour = longitudes[i] / 15;
+    float t = N + ((hour - lngHour) / 24);
+    float M = (0.9856f * t) - 3.289f;
+
+    //calculate the Sun's true longitude, wrapped into [0, 360)
+    float L = M + (1.916f * sinf(DEG * M)) + (0.020f * sinf(DEG * 2 * M)) + 282.634f;
+    L -= 360.0f * fast_floor(L / 360.0f);
+
+    //right ascension in the same quadrant as L, then in hours
+    float RA = (1.0f / DEG) * atanf(0.91764f * tanf(DEG * L));
+    RA -= 360.0f * fast_floor(RA / 360.0f);
+    RA += 90.0f * (fast_floor(L / 90.0f) - fast_floor(RA / 90.0f));
+    RA = RA / 15;
+
+    //the Sun's declination
+    float sinDec = 0.39782f * sinf(DEG * L);
+    float cosDec = sqrtf(1.0f - sinDec * sinDec);
+
+    //local hour angle; outside [-1, 1] the sun never crosses the zenith
+    //cos(lat) as sin(90 - lat): a cosf() of the same argument gets fused into
+    //sincosf(), which does not vectorize, and 1 - sin^2 loses too much near the poles
+    float sinLat = sinf(DEG * latitudes[i]);
+    float cosLat = sinf(DEG * (90.0f - latitudes[i]));
+    float cosH = (cosf(DEG * zeniths[i]) - (sinDec * sinLat)) / (cosDec * cosLat);
+    float valid = (float)(fabsf(cosH) <= 1.0f);
+    cosH = fminf(fmaxf(cosH, -1.0f), 1.0f);
+    float H = (base + sign * (1.0f / DEG) * acosf(cosH)) / 15;
+
+    //local mean time, adjusted back to UTC in [0, 24)
+    float UT = H + RA - (0.06571f * t) - 6.622f - lngHour;
+    UT -= 24.0f * fast_floor(UT / 24.0f);
+
+    res[i] = valid * UT;
+  }
+}
+
+typedef struct {
+  const SunBatch *in;
+  size_t first;
+  size_t count;
+  int sunset;
+  float *out;
+} SunBatchJob;
+
+static void *run_job(void *arg)
+{
+  SunBatchJob *job = arg;
+  calcSunBatch(job->in, job->first, job->count, job->sunset, job->out);
+  return NULL;
+}
+
+void calcSunBatchThreaded(const SunBatch *in, size_t count, int sunset, float *out, int threads)
+{
+  pthread_t tid[64];
+  SunBatchJob jobs[64];
+  size_t chunk, first = 0;
+  int joinable[64];
+  int i;
+
+  if (threads < 1) threads = 1;
+  if (threads > 64) threads = 64;
+  chunk = (count + threads - 1) / threads;
+
+  for (i = 0; i < threads && first < count; i++)
+  {
+    jobs[i].in = in;
+    jobs[i].first = first;
+    jobs[i].count = (count - first < chunk) ? count - first : chunk;
+    jobs[i].sunset = sunset;
+    jobs[i].out = out;
+    first += jobs[i].count;
+    joinable[i] = pthread_create(&tid[i], NULL, run_job, &jobs[i]) == 0;
+    //fall back to doing this chunk on the calling thread
+    if (!joinable[i]) run_job(&jobs[i]);
+  }
+
+  while (i-- > 0)
+    if (joinable[i]) pthread_join(tid[i], NULL);
+}
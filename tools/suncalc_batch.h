@@ -0,0 +1,21 @@
+#include <stddef.h>
+
+/*
+ * structure-of-arrays input for calcSunBatch; element i of every array
+ * describes one event to evaluate
+ *
+ * calcSunBatch evaluates elements [first, first + count) and writes the
+ * result for element i to out[i], so out must hold first + count floats,
+ * not just count.
+ */
+typedef struct {
+  const int *year;
+  const int *month;
+  const int *day;
+  const float *latitude;
+  const float *longitude;
+  const float *zenith;
+} SunBatch;
+
+void calcSunBatch(const SunBatch *in, size_t first, size_t count, int sunset, float *out);
+void calcSunBatchThreaded(const SunBatch *in, size_t count, int sunset, float *out, int threads);
@@ -0,0 +1,73 @@
+/*
+ * suncalc_bench - report calcSunBatch throughput
+ *
+ * usage: suncalc_bench [events] [threads]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "suncalc_batch.h"
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+  size_t count = argc > 1 ? strtoul(argv[1], NULL, 10) : 10000000;
+  int threads = argc > 2 ? atoi(argv[2]) : 4;
+  int *year = malloc(count * sizeof(*year));
+  int *month = malloc(count * sizeof(*month));
+  int *day = malloc(count * sizeof(*day));
+  float *lat = malloc(count * sizeof(*lat));
+  float *lon = malloc(count * sizeof(*lon));
+  float *zenith = malloc(count * sizeof(*zenith));
+  float *out = malloc(count * sizeof(*out));
+  float checksum = 0;
+  SunBatch batch;
+  double start, single, multi;
+  size_t i;
+
+  if (!year || !month || !day || !lat || !lon || !zenith || !out)
+  {
+    fprintf(stderr, "%s: out of memory\n", argv[0]);
+    return 1;
+  }
+
+  srand(1);
+  for (i = 0; i < count; i++)
+  {
+    year[i] = 2000 + rand() % 50;
+    month[i] = 1 + rand() % 12;
+    day[i] = 1 + rand() % 28;
+    lat[i] = rand() * 180.0f / RAND_MAX - 90;
+    lon[i] = rand() * 360.0f / RAND_MAX - 180;
+    zenith[i] = 90.83f;
+  }
+  batch.year = year;
+  batch.month = month;
+  batch.day = day;
+  batch.latitude = lat;
+  batch.longitude = lon;
+  batch.zenith = zenith;
+
+  start = now();
+  calcSunBatch(&batch, 0, count, 1, out);
+  single = now() - start;
+
+  start = now();
+  calcSunBatchThreaded(&batch, count, 1, out, threads);
+  multi = now() - start;
+
+  for (i = 0; i < count; i++)
+    checksum += out[i];
+
+  printf("events: %lu\n", (unsigned long)count);
+  printf("1 thread: %.0f events/s\n", count / single);
+  printf("%d threads: %.0f events/s\n", threads, count / multi);
+  printf("checksum: %f\n", checksum);
+  return 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * suncalc_check - compare calcSunBatch with the watch's calcSun
+ *
+ * Runs both over a fixed grid of dates, locations and zeniths. No-event (0)
+ * results must match exactly; times must agree within TOLERANCE minutes.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "suncalc.h"
+#include "suncalc_batch.h"
+
+#define TOLERANCE 1.5f
+
+//every 10 degrees, plus the polar circles where float precision is tightest
+static const float latitudes[] = {
+  -89.9f, -88.5f, -86.3f, -84.63f, -74.63f, -64.63f, -54.63f, -44.63f, -34.63f, -24.63f, -14.63f, -4.63f,
+  5.37f, 15.37f, 25.37f, 35.37f, 45.37f, 55.37f, 65.37f, 75.37f, 85.37f, 86.3f, 88.5f, 89.9f
+};
+static const float zeniths[] = {ZENITH_OFFICIAL, ZENITH_CIVIL, ZENITH_NAUTICAL, ZENITH_ASTRONOMICAL};
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+//9 years * 12 months * 4 days * latitudes * 8 longitudes * zeniths
+#define EVENTS (9 * 12 * 4 * COUNT(latitudes) * 8 * COUNT(zeniths))
+
+int main(void)
+{
+  size_t count = 0, capacity = EVENTS, i;
+  int *year = malloc(capacity * sizeof(*year));
+  int *month = malloc(capacity * sizeof(*month));
+  int *day = malloc(capacity * sizeof(*day));
+  float *lat = malloc(capacity * sizeof(*lat));
+  float *lon = malloc(capacity * sizeof(*lon));
+  float *zenith = malloc(capacity * sizeof(*zenith));
+  float *out = malloc(capacity * sizeof(*out));
+  float worst = 0;
+  int y, m, d, la, lo, z, sunset, failures = 0;
+  SunBatch batch;
+
+  if (!year || !month || !day || !lat || !lon || !zenith || !out)
+  {
+    fprintf(stderr, "suncalc_check: out of memory\n");
+    return 1;
+  }
+
+  for (y = 2014; y <= 2038; y += 3)
+    for (m = 1; m <= 12; m++)
+      for (d = 1; d <= 28; d += 9)
+        for (la = 0; la < (int)COUNT(latitudes); la++)
+          for (lo = -180; lo < 180; lo += 45)
+            for (z = 0; z < (int)COUNT(zeniths); z++)
+            {
+              year[count] = y;
+              month[count] = m;
+              day[count] = d;
+              lat[count] = latitudes[la];
+              lon[count] = lo + 0.61f;
+              zenith[count] = zeniths[z];
+              count++;
+            }
+
+  batch.year = year;
+  batch.month = month;
+  batch.day = day;
+  batch.latitude = lat;
+  batch.longitude = lon;
+  batch.zenith = zenith;
+
+  for (sunset = 0; sunset < 2; sunset++)
+  {
+    calcSunBatch(&batch, 0, count, sunset, out);
+    for (i = 0; i < count; i++)
+    {
+      float expected = calcSun(year[i], month[i], day[i], lat[i], lon[i], sunset, zenith[i]);
+      float diff = 60 * (out[i] - expected);
+
+      //times are on a 24 hour circle
+      if (diff > 12 * 60) diff -= 24 * 60;
+      if (diff < -12 * 60) diff += 24 * 60;
+      if (diff < 0) diff = -diff;
+
+      if ((out[i] == 0) != (expected == 0) || diff > TOLERANCE)
+      {
+        if (failures++ < 10)
+          fprintf(stderr, "%d-%02d-%02d %.2f %.2f zenith %.2f %s: batch %f, watch %f\n",
+                  year[i], month[i], day[i], lat[i], lon[i], zenith[i],
+                  sunset ? "set" : "rise", out[i], expected);
+        continue;
+      }
+      if (diff > worst) worst = diff;
+    }
+  }
+
+  printf("%lu events, max difference %.2f minutes, %d failures\n", (unsigned long)count * 2, worst, failures);
+  return failures != 0;
+}
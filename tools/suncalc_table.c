@@ -0,0 +1,229 @@
+/*
+ * suncalc_table - precompute sunrise/sunset tables on the host
+ *
+ * usage: suncalc_table [-t threads] out.bin < tables.txt
+ *
+ * Each input line asks for one table:
+ *   latitude longitude zenith year month day days
+ * covering `days` consecutive days starting at year-month-day. The tables
+ * are written to out.bin back to back, in input order.
+ *
+ * A table is laid out as the values the watch stores with persist_write_data,
+ * none of them longer than PERSIST_DATA_MAX_LENGTH (256 bytes). Everything is
+ * little-endian.
+ *
+ * Header value (24 bytes), stored at key K:
+ *    0  "SUNT"
+ *    4  u16 version (2)
+ *    6  u16 chunk count
+ *    8  i16 start year
+ *   10  u8  start month (1-12)
+ *   11  u8  start day (1-31)
+ *   12  u16 day count
+ *   14  u16 zenith, in hundredths of a degree
+ *   16  i32 latitude, in the watch's location_decimals (1e-4 degrees)
+ *   20  i32 longitude, same units
+ *
+ * Chunk values, stored at keys K+1 .. K+chunk count: up to 64 records of
+ * 4 bytes each, so every chunk but the last is exactly 256 bytes. Day d of
+ * the table (0 = start date) is at byte 4*(d%64) of chunk d/64:
+ *    0  u16 sunrise
+ *    2  u16 sunset
+ * in minutes after 00:00 UTC, 0xFFFF where the sun does not rise or set.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "suncalc_batch.h"
+
+#define TABLE_VERSION 2
+#define HEADER_SIZE 24
+#define RECORD_SIZE 4
+#define CHUNK_RECORDS 64
+#define NO_EVENT 0xFFFF
+#define LOCATION_DECIMALS 1e4
+
+typedef struct {
+  float latitude;
+  float longitude;
+  float zenith;
+  int year;
+  int month;
+  int day;
+  int days;
+} TableSpec;
+
+static void put16(unsigned char *p, unsigned v)
+{
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+}
+
+static void put32(unsigned char *p, unsigned long v)
+{
+  put16(p, v & 0xFFFF);
+  put16(p + 2, (v >> 16) & 0xFFFF);
+}
+
+static long to_fixed(float x, double scale)
+{
+  return (long)(x * scale + (x < 0 ? -0.5 : 0.5));
+}
+
+static unsigned to_minutes(float ut)
+{
+  //calcSun uses 0 for "no event", same as on the watch
+  if (ut == 0) return NO_EVENT;
+  return (unsigned)(ut * 60 + 0.5f) % (24 * 60);
+}
+
+static int days_in_month(int year, int month)
+{
+  static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  int leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  return days[month - 1] + (month == 2 && leap);
+}
+
+static int valid_spec(const TableSpec *s)
+{
+  return s->latitude >= -90 && s->latitude <= 90 &&
+         s->longitude >= -180 && s->longitude <= 180 &&
+         s->zenith > 0 && s->zenith < 180 &&
+         s->year >= 1 && s->year <= 32767 &&
+         s->month >= 1 && s->month <= 12 &&
+         s->day >= 1 && s->day <= days_in_month(s->year, s->month) &&
+         s->days >= 1 && s->days <= 65535;
+}
+
+int main(int argc, char **argv)
+{
+  size_t nspecs = 0, spec_capacity = 64, count = 0, capacity = 0, i, k;
+  int threads = 4, d, failed = 0;
+  TableSpec *specs, spec;
+  int *year = NULL, *month = NULL, *day = NULL;
+  float *lat = NULL, *lon = NULL, *zenith = NULL, *rise, *set;
+  SunBatch batch;
+  unsigned char header[HEADER_SIZE], record[RECORD_SIZE];
+  FILE *out;
+
+  if (argc == 4 && strcmp(argv[1], "-t") == 0)
+  {
+    threads = atoi(argv[2]);
+    argv += 2;
+    argc -= 2;
+  }
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s [-t threads] out.bin < tables.txt\n", argv[0]);
+    return 2;
+  }
+
+  if (!(specs = malloc(spec_capacity * sizeof(*specs)))) goto oom;
+  for (;;)
+  {
+    int fields = scanf("%f %f %f %d %d %d %d", &spec.latitude, &spec.longitude, &spec.zenith,
+                       &spec.year, &spec.month, &spec.day, &spec.days);
+    if (fields == EOF && !ferror(stdin)) break;
+    if (fields != 7)
+    {
+      fprintf(stderr, "%s: bad input at line %lu\n", argv[0], (unsigned long)nspecs + 1);
+      return 1;
+    }
+    if (!valid_spec(&spec))
+    {
+      fprintf(stderr, "%s: bad table at line %lu\n", argv[0], (unsigned long)nspecs + 1);
+      return 1;
+    }
+    if (nspecs == spec_capacity)
+    {
+      spec_capacity *= 2;
+      if (!(specs = realloc(specs, spec_capacity * sizeof(*specs)))) goto oom;
+    }
+    specs[nspecs++] = spec;
+    capacity += spec.days;
+  }
+
+  //expand every table into one event per day
+  year = malloc((capacity + 1) * sizeof(*year));
+  month = malloc((capacity + 1) * sizeof(*month));
+  day = malloc((capacity + 1) * sizeof(*day));
+  lat = malloc((capacity + 1) * sizeof(*lat));
+  lon = malloc((capacity + 1) * sizeof(*lon));
+  zenith = malloc((capacity + 1) * sizeof(*zenith));
+  rise = malloc((capacity + 1) * sizeof(*rise));
+  set = malloc((capacity + 1) * sizeof(*set));
+  if (!year || !month || !day || !lat || !lon || !zenith || !rise || !set) goto oom;
+
+  for (k = 0; k < nspecs; k++)
+  {
+    int y = specs[k].year, m = specs[k].month, dd = specs[k].day;
+    for (d = 0; d < specs[k].days; d++)
+    {
+      year[count] = y;
+      month[count] = m;
+      day[count] = dd;
+      lat[count] = specs[k].latitude;
+      lon[count] = specs[k].longitude;
+      zenith[count] = specs[k].zenith;
+      count++;
+      if (++dd > days_in_month(y, m))
+      {
+        dd = 1;
+        if (++m > 12)
+        {
+          m = 1;
+          y++;
+        }
+      }
+    }
+  }
+
+  batch.year = year;
+  batch.month = month;
+  batch.day = day;
+  batch.latitude = lat;
+  batch.longitude = lon;
+  batch.zenith = zenith;
+  calcSunBatchThreaded(&batch, count, 0, rise, threads);
+  calcSunBatchThreaded(&batch, count, 1, set, threads);
+
+  out = fopen(argv[1], "wb");
+  if (!out)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+  for (k = 0, i = 0; k < nspecs; k++)
+  {
+    memcpy(header, "SUNT", 4);
+    put16(header + 4, TABLE_VERSION);
+    put16(header + 6, (specs[k].days + CHUNK_RECORDS - 1) / CHUNK_RECORDS);
+    put16(header + 8, specs[k].year);
+    header[10] = specs[k].month;
+    header[11] = specs[k].day;
+    put16(header + 12, specs[k].days);
+    put16(header + 14, to_fixed(specs[k].zenith, 100));
+    put32(header + 16, to_fixed(specs[k].latitude, LOCATION_DECIMALS));
+    put32(header + 20, to_fixed(specs[k].longitude, LOCATION_DECIMALS));
+    failed |= fwrite(header, sizeof(header), 1, out) != 1;
+
+    //chunks are contiguous, so the records can be written straight through
+    for (d = 0; d < specs[k].days; d++, i++)
+    {
+      put16(record, to_minutes(rise[i]));
+      put16(record + 2, to_minutes(set[i]));
+      failed |= fwrite(record, sizeof(record), 1, out) != 1;
+    }
+  }
+  //a short table would still load on the watch, so any write error is fatal
+  if (fclose(out) != 0 || failed)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+  return 0;
+
+oom:
+  fprintf(stderr, "%s: out of memory\n", argv[0]);
+  return 1;
+}